@@ -0,0 +1,164 @@
+#include "bigmath.h"
+
+/*
+ *	Shift len words of src left by shift (< 32) bits into dst, returns bits shifted out of MSW.
+ *	Every word is computed from two source words only, so the loop can be vectorized
+ */
+ul shlwords(ul* RESTRICT dst, const ul* RESTRICT src, long len, short shift)
+{
+	if (shift == 0) // Nothing to borrow, just copy
+	{
+		memcpy(dst, src, len * sizeof(ul));
+		return 0;
+	}
+
+	for (long i = len - 1; i > 0; i--)
+		dst[i] = (src[i] << shift) | (src[i - 1] >> (32 - shift));	// Shift left whole number, borrowing bits from previous words
+	dst[0] = src[0] << shift;	// Just shift LSW
+
+	return src[len - 1] >> (32 - shift);
+}
+
+/*
+ *	Shift len words of src right by shift (< 32) bits into dst
+ */
+void shrwords(ul* RESTRICT dst, const ul* RESTRICT src, long len, short shift)
+{
+	if (shift == 0) // Nothing to borrow, just copy
+	{
+		memcpy(dst, src, len * sizeof(ul));
+		return;
+	}
+
+	for (long i = 0; i < len - 1; i++)
+		dst[i] = (src[i] >> shift) | (src[i + 1] << (32 - shift));	// Shift right whole number, borrowing bits from next words
+	dst[len - 1] = src[len - 1] >> shift;	// Just shift MSW
+}
+
+/*
+ *	Shift BigInt left by b bits
+ */
+void bigshl(BigInt* a, BigInt* b, BigInt* res)
+{
+	BigInt dest;
+
+	if (b->len > 1)	// Only allow for one-word shifts
+	{
+		fprintf(stderr, "Shift is to big!\n");
+		longjmp(exception, 1);
+	}
+
+	ul bits = b->vals[0];
+	long words = bits / 32;
+
+	if (iszero(*a) || bits == 0) // Nothing to shift
+	{
+		bigcpy(a, res);
+		return;
+	}
+
+	// Result is a shifted by whole words and then by the rest of bits
+	dest.len = a->len + words + 1;
+	dest.vals = alloc(dest.len);
+	memset(dest.vals, 0, words * sizeof(ul));
+	dest.vals[dest.len - 1] = shlwords(dest.vals + words, a->vals, a->len, bits % 32);
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Shift BigInt right by b bits
+ */
+void bigshr(BigInt* a, BigInt* b, BigInt* res)
+{
+	BigInt dest;
+
+	if (b->len > 1)	// Shift longer than one word shifts out everything
+	{
+		*res = _zero;
+		return;
+	}
+
+	ul bits = b->vals[0];
+	long words = bits / 32;
+
+	if (words >= a->len) // Everything is shifted out
+	{
+		*res = _zero;
+		return;
+	}
+
+	if (bits == 0) // Nothing to shift
+	{
+		bigcpy(a, res);
+		return;
+	}
+
+	// Drop whole words and shift the rest
+	dest.len = a->len - words;
+	dest.vals = alloc(dest.len);
+	shrwords(dest.vals, a->vals + words, dest.len, bits % 32);
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Bitwise and of two BigInts
+ */
+void bigand(BigInt* a, BigInt* b, BigInt* res)
+{
+	BigInt dest;
+
+	// Result is at most as long as shorter number
+	dest.len = a->len < b->len ? a->len : b->len;
+	dest.vals = alloc(dest.len);
+
+	for (long i = 0; i < dest.len; i++)
+		dest.vals[i] = a->vals[i] & b->vals[i];
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Bitwise or (or xor, if exclusive is set) of two BigInts
+ */
+static void bigorx(BigInt* a, BigInt* b, int exclusive, BigInt* res)
+{
+	BigInt dest;
+	BigInt* longer = a->len > b->len ? a : b;
+	BigInt* shorter = a->len > b->len ? b : a;
+
+	// Result is at most as long as longer number, its rest is just copied
+	dest.len = longer->len;
+	dest.vals = alloc(dest.len);
+
+	if (exclusive)
+		for (long i = 0; i < shorter->len; i++)
+			dest.vals[i] = a->vals[i] ^ b->vals[i];
+	else
+		for (long i = 0; i < shorter->len; i++)
+			dest.vals[i] = a->vals[i] | b->vals[i];
+	memcpy(dest.vals + shorter->len, longer->vals + shorter->len, (longer->len - shorter->len) * sizeof(ul));
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Bitwise or of two BigInts
+ */
+void bigor(BigInt* a, BigInt* b, BigInt* res)
+{
+	bigorx(a, b, 0, res);
+}
+
+/*
+ *	Bitwise exclusive or of two BigInts
+ */
+void bigxor(BigInt* a, BigInt* b, BigInt* res)
+{
+	bigorx(a, b, 1, res);
+}
\ No newline at end of file
@@ -1,15 +1,44 @@
 #include "bigmath.h"
 
 /*
- * Divide two big integers with remainder using Knuth algorithm
+ *	Cached divisors. Single word divisors (like base when printing) are kept separately,
+ *	so that they do not evict the bigger divisor shared by consecutive calculations
  */
-void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
+static BigDivisor cache_word, cache_big;
+
+/*
+ *	Divide two word number [u1 u0] by normalized word d using its reciprocal (Moller-Granlund), u1 must be smaller than d
+ */
+static ul divword(ul u1, ul u0, ul d, ul inv, ul* rem)
 {
-	int i;
-	register ul* uptr, * qptr;
-	ull remainder;
-	long long res;
-	BIGUNION qunion, runion;
+	BIGUNION qunion;
+	ul r;
+
+	qunion.value = (ull)inv * u1 + ((ull)(u1 + 1) << 32) + u0;	// Estimate quotient, it is at most one off
+	r = u0 - qunion.svals.high * d;								// Calculate remainder modulo word
+
+	if (r > qunion.svals.low)	// Estimate was one too big
+	{
+		qunion.svals.high--;
+		r += d;
+	}
+
+	if (r >= d)	// Estimate was one too small
+	{
+		qunion.svals.high++;
+		r -= d;
+	}
+
+	*rem = r;
+	return qunion.svals.high;
+}
+
+/*
+ *	Precompute normalized divisor and reciprocal of its MSW
+ */
+void bigdivprep(BigInt* v, BigDivisor* d)
+{
+	const long n = v->len;
 
 	// Check if we don't divide by 0
 	if (iszero(*v))
@@ -18,41 +47,84 @@ void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
 		longjmp(exception, 1);
 	}
 
+	// Count number of bits we have to shift divisor left by, so that MSb of divisor is 1
+	short nobits = 1;
+	ul msw = v->vals[n - 1];
+	while (msw >>= 1)	// count number of bits of MSW of divisor
+		nobits++;
+
+	d->vals = alloc(n);
+	bigcpy(v, &d->divisor);	// Keep original divisor, so that it can be recognized later
+	d->shift = 32 - nobits;
+	shlwords(d->vals, v->vals, n, d->shift);	// normalize divisor, no bits are shifted out
+
+	d->inv = (ul)(ULLONG_MAX / d->vals[n - 1] - ((ull)1 << 32));	// floor((word^2 - 1) / MSW) - word
+}
+
+/*
+ *	Free precomputed divisor
+ */
+void bigdivfree(BigDivisor* d)
+{
+	freeval(d->divisor);
+	freearr(d->vals);
+	d->vals = NULL;
+}
+
+/*
+ * Divide two big integers with remainder by precomputed divisor using Knuth algorithm
+ */
+void bigdivpre(BigInt* u, BigDivisor* d, BigInt* quo, BigInt* rem)
+{
+	int i;
+	register ul* uptr, * qptr;
+	ul remainder;
+	long long res;
+	BIGUNION qunion, runion;
+
+	const ul* vptr = d->vals;
+	const short shift = d->shift;
 	const long m = u->len;
-	const long n = v->len;
+	const long n = d->divisor.len;
 	long qlen = m - n + 1; // quotient will be at most u.len - v.len + 1
 
 	if (m < n) // a is definitely smaller, we can set quo = 0, rem = a
 	{
 		*quo = _zero;
-		bigcpy(u, rem);
+		if (rem != NULL) // Remainder is requested
+			bigcpy(u, rem);
 
 		return;
 	}
 	else if (n == 1) // divisor is only one word long, we can just divide by it
 	{
 		// divisor is one, we can just copy dividend to quo
-		if (v->vals[0] == 1)
+		if (d->divisor.vals[0] == 1)
 		{
 			bigcpy(u, quo);
-			*rem = _zero;
+			if (rem != NULL) // Remainder is requested
+				*rem = _zero;
 
 			return;
 		}
 
-		remainder = 0;
 		uptr = u->vals + m;
 
 		quo->len = qlen; // alloc space for quotient
 		quo->vals = alloc(qlen);
 		qptr = quo->vals + qlen;
-		
-		// Perform basic long division
+
+		// Perform basic long division of dividend shifted the same way as divisor
+		runion.svals.high = 0;
+		runion.svals.low = *(uptr - 1);
+		runion.value <<= shift;
+		remainder = runion.svals.high;	// Bits shifted out of MSW
 		while (qlen--)
 		{
-			remainder = remainder << 32 | *--uptr;
-			*--qptr = (ul)(remainder / v->vals[0]);	
-			remainder = remainder % v->vals[0];
+			runion.svals.high = *--uptr;
+			runion.svals.low = qlen ? *(uptr - 1) : 0;
+			runion.value <<= shift;		// Next word of shifted dividend is in high word
+			*--qptr = divword(remainder, runion.svals.high, vptr[0], d->inv, &remainder);
 		}
 
 		bigtrim(quo); // Trim leading 0s from result
@@ -60,7 +132,7 @@ void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
 		{
 			rem->len = 1;
 			rem->vals = alloc(1);
-			rem->vals[0] = (ul)remainder;
+			rem->vals[0] = remainder >> shift; // Unnormalize remainder
 		}
 		return;
 	}
@@ -69,24 +141,9 @@ void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
 	 *	Knuth division
 	 */
 
-	// 1. Normalize	(shift divisor and dividend left until MSb of divisor is 1)
-	short nobits = 1;
-	ul msw = v->vals[n - 1];
-	while (msw >>= 1)	// count number of bits of MSW of divisor
-		nobits++;
-
-	// normalize divisor
-	register ul* vptr = alloc(n);
-	for (i = n - 1; i > 0; i--)
-		vptr[i] = ((ull)v->vals[i] << (32 - nobits)) | ((ull)v->vals[i - 1] >> nobits);	// Shift left whole number, borrowing bits from previous words
-	vptr[0] = v->vals[0] << (32 - nobits);	// Just shift LSW
-
-	// normalize dividend
+	// 1. Normalize	dividend (divisor is already normalized)
 	uptr = alloc(m+1);	// dividend may get bigger by one word
-	uptr[m] = (ull)u->vals[m - 1] >> nobits;	// Shift MSW overflow
-	for (i = m - 1; i > 0; i--)
-		uptr[i] = (u->vals[i] << (32 - nobits)) | ((ull)u->vals[i - 1] >> nobits);	// Shift left whole number, borrowing bits from previous words
-	uptr[0] = u->vals[0] << (32 - nobits); // Just shift LSW
+	uptr[m] = shlwords(uptr, u->vals, m, shift);	// Shift MSW overflow into new word
 
 	// 2. Initialize
 	quo->len = m - n + 1;
@@ -95,26 +152,32 @@ void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
 
 	for (int j = m - n; j >= 0; j--)
 	{
-		// 3. Estimate q[j], using BIGUNION to avoid unnecessary bit shifts
-		qunion.svals.high =   uptr[j + n];
-		qunion.svals.low  = uptr[j + n - 1];				// qunion now holds [uptr[j+n] uptr[j+n-1]]
-		runion.svals.high  = qunion.value % vptr[n - 1];	// store remainder in runion high word, this will be usefull later
-		runion.svals.low = uptr[j + n - 2];					// store next word in runion low
-		qunion.value /= vptr[n - 1];						// perform division
+		// 3. Estimate q[j] by dividing [uptr[j+n] uptr[j+n-1]] by MSW of divisor, using its reciprocal
+		ull qhat;
+		if (uptr[j + n] >= vptr[n - 1])		// Quotient would not fit in one word, start from maximal one
+		{
+			qhat = ULONG_MAX;
+			runion.value = (ull)uptr[j + n - 1] + vptr[n - 1];	// Remainder of such estimate
+		}
+		else
+		{
+			qhat = divword(uptr[j + n], uptr[j + n - 1], vptr[n - 1], d->inv, &remainder);
+			runion.value = remainder;
+		}
 
 		// Correct q[j]
-		while (qunion.svals.high || qunion.value * vptr[n - 2] > runion.value)	// Estimated q[j] is too big, we have to correct it
+		while (!runion.svals.high)	// remainder bigger than one word means we definitely have correct q[j] now
 		{
-			qunion.value -= 1;									// decrement q[j]
-			remainder = (ull) runion.svals.high + vptr[n - 1];	// calculate new remainder
-			runion.svals.high = remainder;
-			if (remainder > ULONG_MAX)							// remainder is bigger than one word, we definitely have correct q[j] now
+			runion.svals.high = runion.svals.low;	// store remainder in runion high word
+			runion.svals.low = uptr[j + n - 2];		// store next word in runion low
+			if (qhat * vptr[n - 2] <= runion.value)	// Estimated q[j] is not too big
 				break;
+
+			qhat -= 1;												// decrement q[j]
+			runion.value = (ull)runion.svals.high + vptr[n - 1];	// calculate new remainder
 		}
-		
-		ull qhat = qunion.value;	// store qunion in normal variable, as we will need to use BIGUNION later
 
-		// 4. Multiply and subtract, we can reuse qunion
+		// 4. Multiply and subtract
 		long long carry = 0;
 		for (i = 0; i < n; i++)
 		{
@@ -136,8 +199,8 @@ void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
 			for (i = 0; i < n; i++)
 			{
 				qunion.value = (ull)uptr[i + j] + (ull)vptr[i] + carry;	// Add dividend word + divisor word + carry
-				uptr[i + j] = qunion.svals.low;							// low word of sum is result 
-				carry = qunion.svals.high;								// high word of sum is carry 
+				uptr[i + j] = qunion.svals.low;							// low word of sum is result
+				carry = qunion.svals.high;								// high word of sum is carry
 			}
 			uptr[j + n] += carry;	// add carry to last word
 		}
@@ -152,17 +215,58 @@ void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
 		rem->len = n;
 		rem->vals = alloc(n);	// alloc memory for remainder
 		// 8. Unnormalize (shift back to normal)
-		for (i = 0; i < n - 1; i++)
-			rem->vals[i] = (uptr[i] >> (32 - nobits)) | ((ull)uptr[i + 1] << nobits);
-		rem->vals[n - 1] = uptr[n - 1] >> (32 - nobits);
+		shrwords(rem->vals, uptr, n, shift);
 		bigtrim(rem); // Trim leading 0s from remainder
 	}
 
-	// Free normalized values
-	freearr(vptr);
+	// Free normalized dividend
 	freearr(uptr);
 }
 
+/*
+ *	Store two word value in BigInt
+ */
+static void divresult(ull value, BigInt* big)
+{
+	BIGUNION bigunion;
+
+	bigunion.value = value;
+	big->vals = alloc(2);
+	big->vals[0] = bigunion.svals.low;
+	big->vals[1] = bigunion.svals.high;
+	big->len = bigunion.svals.high ? 2 : 1;
+}
+
+/*
+ * Divide two big integers with remainder, reusing precomputed divisor if it was used last time
+ */
+void bigdiv(BigInt* u, BigInt* v, BigInt* quo, BigInt* rem)
+{
+	BigDivisor* d = v->len == 1 ? &cache_word : &cache_big;
+
+	if (u->len <= 2 && v->len <= 2 && !iszero(*v)) // Both numbers fit in two words, divide directly without touching the cache
+	{
+		ull x = u->vals[0] | (u->len > 1 ? (ull)u->vals[1] << 32 : 0);
+		ull y = v->vals[0] | (v->len > 1 ? (ull)v->vals[1] << 32 : 0);
+
+		divresult(x / y, quo);
+		if (rem != NULL) // Remainder is requested
+			divresult(x % y, rem);
+		return;
+	}
+
+	// Precompute divisor unless it is cached already
+	if (d->vals == NULL || d->divisor.len != v->len || memcmp(d->divisor.vals, v->vals, v->len * sizeof(ul)) != 0)
+	{
+		if (d->vals != NULL)
+			bigdivfree(d);
+
+		bigdivprep(v, d);
+	}
+
+	bigdivpre(u, d, quo, rem);
+}
+
 void bigquo(BigInt* a, BigInt* b, BigInt* res)
 {
 	bigdiv(a, b, res, NULL); // Quotient can be calculated by just not passing remainder pointer
@@ -173,4 +277,15 @@ void bigmod(BigInt* a, BigInt* b, BigInt* res)
 	BigInt tmp;
 	bigdiv(a, b, &tmp, res); // Pass temporary quotionent pointer
 	freeval(tmp);			 // Free no longer needed pointer
+}
+
+/*
+ *	Free cached divisors
+ */
+void divcleanup(void)
+{
+	if (cache_word.vals != NULL)
+		bigdivfree(&cache_word);
+	if (cache_big.vals != NULL)
+		bigdivfree(&cache_big);
 }
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "bigmath.h"
+
+/*
+ *	Biggest argument for which primes are sieved
+ */
+#define FACT_LIMIT	(1UL << 26)
+
+/*
+ *	Products of at most that many words are calculated directly
+ */
+#define PROD_LEAF	16
+
+/*
+ *	Multiply words using balanced product tree
+ */
+static void wordprod(ul* words, long count, BigInt* res)
+{
+	BigInt dest, left, right;
+	BIGUNION bigunion;
+
+	if (count == 0) // Empty product
+	{
+		*res = _one;
+		return;
+	}
+
+	if (count > PROD_LEAF) // Multiply both halves separately, so that factors in every multiplication are of similar size
+	{
+		wordprod(words, count / 2, &left);
+		wordprod(words + count / 2, count - count / 2, &right);
+		bigmul(&left, &right, res);
+		freeval(left);
+		freeval(right);
+		return;
+	}
+
+	// Few words, multiply them one by one. Product of count words is at most count words long
+	dest.vals = alloc(count);
+	dest.vals[0] = 1;
+	dest.len = 1;
+	for (long i = 0; i < count; i++)
+	{
+		ull carry = 0;
+		for (long j = 0; j < dest.len; j++)
+		{
+			bigunion.value = (ull)dest.vals[j] * words[i] + carry;	// Multiply word of product by next word + carry
+			dest.vals[j] = bigunion.svals.low;						// low word is result
+			carry = bigunion.svals.high;							// high word is carry
+		}
+		if (carry)
+			dest.vals[dest.len++] = (ul)carry;	// put carry in new MSW of product
+	}
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Find all primes up to n using sieve of Eratosthenes, returns their count
+ */
+static long primesupto(ul n, ul** primes)
+{
+	char* composite;
+	long count = 0;
+	ul i, j;
+
+	if ((composite = (char*)calloc((size_t)n + 1, 1)) == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory for sieve!\n");
+		longjmp(exception, 1);
+	}
+
+	for (i = 2; i <= n; i++)
+	{
+		if (composite[i])
+			continue;
+
+		count++;
+		for (j = i * i; i <= n / i && j <= n; j += i)	// Strike out multiples of prime, starting from its square
+			composite[j] = 1;
+	}
+
+	if ((*primes = (ul*)malloc(((size_t)count + 1) * sizeof(ul))) == NULL)
+	{
+		free(composite);
+		fprintf(stderr, "Could not allocate memory for primes!\n");
+		longjmp(exception, 1);
+	}
+
+	count = 0;
+	for (i = 2; i <= n; i++)
+		if (!composite[i])
+			(*primes)[count++] = i;
+
+	free(composite);
+	return count;
+}
+
+/*
+ *	Swinging factorial n!/((n/2)!)^2 from its prime factorization, factors is buffer for prime powers
+ */
+static void swing(ul n, ul* primes, long noprimes, ul* factors, BigInt* res)
+{
+	long count = 0;
+	ul p, q, f;
+
+	for (long i = 0; i < noprimes && primes[i] <= n; i++)
+	{
+		p = primes[i];
+		f = 1;
+		q = n;
+		while ((q /= p) > 0)	// Exponent of p is number of odd floor(n / p^i)
+			if (q & 1)
+				f *= p;			// Such power is never bigger than n
+
+		if (f > 1)
+			factors[count++] = f;
+	}
+
+	wordprod(factors, count, res);
+}
+
+/*
+ *	Factorial using prime swing: n! = ((n/2)!)^2 * swing(n)
+ */
+static void factrec(ul n, ul* primes, long noprimes, ul* factors, BigInt* res)
+{
+	BigInt half, sqr, sw;
+
+	if (n < 2)	// 0! = 1! = 1
+	{
+		*res = _one;
+		return;
+	}
+
+	factrec(n / 2, primes, noprimes, factors, &half);
+	bigsqr(&half, &sqr);
+	freeval(half);
+
+	swing(n, primes, noprimes, factors, &sw);
+	bigmul(&sqr, &sw, res);
+	freeval(sqr);
+	freeval(sw);
+}
+
+/*
+ *	Get one word argument of factorial or binomial coefficient
+ */
+static ul factarg(BigInt* a)
+{
+	if (a->len > 1 || a->vals[0] > FACT_LIMIT)
+	{
+		fprintf(stderr, "Argument is too big!\n");
+		longjmp(exception, 1);
+	}
+
+	return a->vals[0];
+}
+
+/*
+ *	Factorial of BigInt
+ */
+void bigfact(BigInt* a, BigInt* res)
+{
+	ul* primes;
+	ul* factors;
+	ul n = factarg(a);
+
+	long noprimes = primesupto(n, &primes);
+	if ((factors = (ul*)malloc(((size_t)noprimes + 1) * sizeof(ul))) == NULL)
+	{
+		free(primes);
+		fprintf(stderr, "Could not allocate memory for primes!\n");
+		longjmp(exception, 1);
+	}
+
+	factrec(n, primes, noprimes, factors, res);
+	free(factors);
+	free(primes);
+}
+
+/*
+ *	Binomial coefficient a over b from its prime factorization
+ */
+void bigbinom(BigInt* a, BigInt* b, BigInt* res)
+{
+	ul* primes;
+	ul* factors;
+	ull pk;
+	ul f;
+	long count = 0;
+
+	if (bigcmp(b, a) > 0) // b > a, no such subsets
+	{
+		*res = _zero;
+		return;
+	}
+
+	ul n = factarg(a);
+	ul k = b->vals[0];
+
+	long noprimes = primesupto(n, &primes);
+	if ((factors = (ul*)malloc(((size_t)noprimes + 1) * sizeof(ul))) == NULL)
+	{
+		free(primes);
+		fprintf(stderr, "Could not allocate memory for primes!\n");
+		longjmp(exception, 1);
+	}
+
+	for (long i = 0; i < noprimes; i++)
+	{
+		f = 1;
+		for (pk = primes[i]; pk <= n; pk *= primes[i])	// Exponent of p is number of carries when adding k and n - k in base p
+			if (n / pk - k / pk - (n - k) / pk)
+				f *= primes[i];	// Such power is never bigger than n
+
+		if (f > 1)
+			factors[count++] = f;
+	}
+
+	wordprod(factors, count, res);
+	free(factors);
+	free(primes);
+}
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include "bigmath.h"
+
+/*
+ *	Cofactors of Lehmer steps are kept below this bound, so that combining them with words fits in long long
+ */
+#define LEHMER_LIMIT	(1LL << 30)
+
+/*
+ *	Number of leading bits used to simulate Euclid steps
+ */
+#define LEHMER_BITS		62
+
+/*
+ *	Get lowest 64 bits of BigInt shifted right by given number of bits
+ */
+static ull bigbits(BigInt* big, long start)
+{
+	long word = start / 32;
+	short shift = start % 32;
+	ull low, mid, high;
+
+	low = word < big->len ? big->vals[word] : 0;
+	mid = word + 1 < big->len ? big->vals[word + 1] : 0;
+	high = word + 2 < big->len ? big->vals[word + 2] : 0;
+
+	if (shift == 0) // Whole words, third one is not needed
+		return low | (mid << 32);
+
+	return (low >> shift) | (mid << (32 - shift)) | (high << (64 - shift));
+}
+
+/*
+ *	Calculate x*u + y*v for cofactors of opposite signs, result must be nonnegative and not bigger than u
+ */
+static void bigcomb(BigInt* u, BigInt* v, long long x, long long y, BigInt* res)
+{
+	BigInt dest;
+	long long sum, carry = 0;
+
+	dest.len = u->len;
+	dest.vals = alloc(dest.len);
+
+	for (long i = 0; i < u->len; i++)
+	{
+		sum = x * (long long)u->vals[i] + carry;		// Add `u` word * x + carry
+		if (i < v->len)
+			sum += y * (long long)v->vals[i];			// Add `v` word * y
+		dest.vals[i] = (ul)sum;							// low word of sum is result
+		carry = sum >> 32;								// high word of sum is carry (may be negative)
+	}
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Calculate |x|*s + |y|*t, used for magnitudes of cofactors
+ */
+static void bigcombabs(BigInt* s, BigInt* t, long long x, long long y, BigInt* res)
+{
+	BigInt dest;
+	BIGUNION bigunion;
+	ull carry = 0;
+
+	if (x < 0)
+		x = -x;
+	if (y < 0)
+		y = -y;
+
+	dest.len = (s->len > t->len ? s->len : t->len) + 1;
+	dest.vals = alloc(dest.len);
+
+	for (long i = 0; i < dest.len; i++)
+	{
+		bigunion.value = carry;
+		if (i < s->len)
+			bigunion.value += (ull)x * s->vals[i];	// Add `s` word * |x|
+		if (i < t->len)
+			bigunion.value += (ull)y * t->vals[i];	// Add `t` word * |y|
+		dest.vals[i] = bigunion.svals.low;			// low word of sum is result
+		carry = bigunion.svals.high;				// high word of sum is carry
+	}
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Simulate Euclid steps on leading bits of u and v, until quotients are not certain (Lehmer).
+ *	Returns number of steps done and matrix [A B; C D] transforming (u, v) to new remainders
+ */
+static long lehmer(BigInt* u, BigInt* v, long long* A, long long* B, long long* C, long long* D)
+{
+	long long x, y, q, T, T2;
+	long steps = 0;
+
+	// Take leading bits of u and the same bits of v
+	long start = bigbitlen(u) - LEHMER_BITS;
+	x = (long long)bigbits(u, start);
+	y = (long long)bigbits(v, start);
+
+	*A = 1; *B = 0;
+	*C = 0; *D = 1;
+	while (y + *C != 0 && y + *D != 0)
+	{
+		q = (x + *A) / (y + *C);
+		if (q != (x + *B) / (y + *D) || q >= LEHMER_LIMIT)	// Quotient not certain or cofactors would get too big
+			break;
+
+		T = *A - q * *C;
+		T2 = *B - q * *D;
+		if (T >= LEHMER_LIMIT || T <= -LEHMER_LIMIT || T2 >= LEHMER_LIMIT || T2 <= -LEHMER_LIMIT)
+			break;
+
+		*A = *C; *C = T;
+		*B = *D; *D = T2;
+		T = x - q * y;
+		x = y; y = T;
+		steps++;
+	}
+
+	return steps;
+}
+
+/*
+ *	Euclid step on BigInts: (u, v) = (v, u mod v), quotient is stored in quo if requested
+ */
+static void euclidstep(BigInt* u, BigInt* v, BigInt* quo)
+{
+	BigInt q, r;
+
+	bigdiv(u, v, &q, &r);
+	if (quo != NULL)
+		*quo = q;
+	else
+		freeval(q);
+
+	freeval(*u);
+	*u = *v;
+	*v = r;
+}
+
+/*
+ *	Make BigInt from two words stored in vals
+ */
+static void ulltobig(ull value, ul* vals, BigInt* big)
+{
+	BIGUNION bigunion;
+
+	bigunion.value = value;
+	vals[0] = bigunion.svals.low;
+	vals[1] = bigunion.svals.high;
+	big->vals = vals;
+	big->len = vals[1] ? 2 : 1;
+}
+
+/*
+ *	Greatest common divisor of two BigInts using Lehmer's algorithm
+ */
+void biggcd(BigInt* a, BigInt* b, BigInt* res)
+{
+	BigInt u, v, t, w;
+	long long A, B, C, D;
+	ull x, y, r;
+	ul vals[2];
+
+	// Make local copies, u is the bigger one
+	if (bigcmp(a, b) >= 0)
+	{
+		bigcpy(a, &u);
+		bigcpy(b, &v);
+	}
+	else
+	{
+		bigcpy(b, &u);
+		bigcpy(a, &v);
+	}
+
+	while (!iszero(v))
+	{
+		if (u.len <= 2) // Both numbers fit in two words, finish with ordinary Euclid
+		{
+			x = u.vals[0] | (u.len > 1 ? (ull)u.vals[1] << 32 : 0);
+			y = v.vals[0] | (v.len > 1 ? (ull)v.vals[1] << 32 : 0);
+			while (y)
+			{
+				r = x % y;
+				x = y;
+				y = r;
+			}
+
+			ulltobig(x, vals, &t);
+			freeval(u);
+			freeval(v);
+			bigcpy(&t, &u);
+			v = _zero;
+			break;
+		}
+
+		if (lehmer(&u, &v, &A, &B, &C, &D) == 0) // No step could be simulated, do one division
+		{
+			euclidstep(&u, &v, NULL);
+			continue;
+		}
+
+		// Apply simulated steps to whole numbers
+		bigcomb(&u, &v, A, B, &t);
+		bigcomb(&u, &v, C, D, &w);
+		freeval(u);
+		freeval(v);
+		u = t;
+		v = w;
+	}
+
+	freeval(v);
+	*res = u;
+}
+
+/*
+ *	Modular inverse of a modulo m using extended Lehmer's algorithm
+ */
+void biginv(BigInt* a, BigInt* m, BigInt* res)
+{
+	BigInt u, v, tu, tv, t, w, q;
+	long long A, B, C, D;
+	ull x, y, r;
+	ul vals[2];
+	int vneg = 0;	// Sign of cofactor of v, cofactors of u and v have always opposite signs
+	long steps;
+
+	// u = m with cofactor 0, v = a mod m with cofactor 1
+	bigcpy(m, &u);
+	bigmod(a, m, &v);
+	tu = _zero;
+	tv = _one;
+
+	while (!iszero(v))
+	{
+		if (u.len <= 2) // Both numbers fit in two words, finish with ordinary extended Euclid
+		{
+			x = u.vals[0] | (u.len > 1 ? (ull)u.vals[1] << 32 : 0);
+			y = v.vals[0] | (v.len > 1 ? (ull)v.vals[1] << 32 : 0);
+			while (y)
+			{
+				ulltobig(x / y, vals, &q);
+				r = x % y;
+				x = y;
+				y = r;
+
+				// |t| = |tu| + q * |tv|
+				bigmul(&q, &tv, &t);
+				bigadd(&t, &tu, &w);
+				freeval(t);
+				freeval(tu);
+				tu = tv;
+				tv = w;
+				vneg = !vneg;
+			}
+
+			ulltobig(x, vals, &t);
+			freeval(u);
+			freeval(v);
+			bigcpy(&t, &u);
+			v = _zero;
+			break;
+		}
+
+		if ((steps = lehmer(&u, &v, &A, &B, &C, &D)) == 0) // No step could be simulated, do one division
+		{
+			euclidstep(&u, &v, &q);
+
+			// |t| = |tu| + q * |tv|
+			bigmul(&q, &tv, &t);
+			bigadd(&t, &tu, &w);
+			freeval(q);
+			freeval(t);
+			freeval(tu);
+			tu = tv;
+			tv = w;
+			vneg = !vneg;
+			continue;
+		}
+
+		// Apply simulated steps to whole numbers
+		bigcomb(&u, &v, A, B, &t);
+		bigcomb(&u, &v, C, D, &w);
+		freeval(u);
+		freeval(v);
+		u = t;
+		v = w;
+
+		// And to cofactors, their signs alternate with every step
+		bigcombabs(&tu, &tv, A, B, &t);
+		bigcombabs(&tu, &tv, C, D, &w);
+		freeval(tu);
+		freeval(tv);
+		tu = t;
+		tv = w;
+		if (steps % 2)
+			vneg = !vneg;
+	}
+
+	freeval(v);
+	freeval(tv);
+
+	if (!isone(u)) // Inverse exists only for coprime numbers
+	{
+		freeval(u);
+		freeval(tu);
+		fprintf(stderr, "Numbers are not coprime, inverse does not exist!\n");
+		longjmp(exception, 1);
+	}
+	freeval(u);
+
+	// u = tu * a (mod m), so tu is inverse, but it may be negative
+	bigmod(&tu, m, &t);
+	freeval(tu);
+	if (!vneg && !iszero(t))	// Cofactor of u is negative
+	{
+		bigsub(m, &t, res);
+		freeval(t);
+	}
+	else
+	{
+		*res = t;
+	}
+}
\ No newline at end of file
@@ -66,6 +66,14 @@ void bigadd(BigInt* a, BigInt* b, BigInt* res)
 	dest.len = a->len + 1;
 	dest.vals = alloc(dest.len);
 
+	if (a->len <= SMALL_LIMIT) // Short numbers, use unrolled kernel
+	{
+		smalladd(a, b, dest.vals);
+		dest.len -= dest.vals[a->len] == 0;	// Only carry word may be a leading zero
+		*res = dest;
+		return;
+	}
+
 	// Helper variables
 	ull carry = 0;
 	dest_ptr = dest.vals;
@@ -94,153 +102,208 @@ void bigadd(BigInt* a, BigInt* b, BigInt* res)
 }
 
 /*
- *	Trim leading zeros of number 
+ *	Add any number of BigInts in one pass
  */
-void bigtrim(BigInt* big)
+void bigsum(BigInt* nums, long count, BigInt* res)
 {
-	register ul* ptr = big->vals + big->len - 1;
-	long len = big->len;
-	while (*ptr == 0 && len > 1)  // Traverse `vals` from MSW to LSW and decrease `len` until nonzero word hit, effectively shrinking the `vals` array
+	BigInt dest;
+	long len = 1, i, j;
+	BIGUNION bigunion;
+
+	for (j = 0; j < count; j++) // Find length of the longest number
+		if (nums[j].len > len)
+			len = nums[j].len;
+
+	// Carry stays below count, so result will be at most 1 longer than the longest number
+	dest.len = len + 1;
+	dest.vals = alloc(dest.len);
+
+	ull carry = 0;
+	for (i = 0; i < len; i++) // Column addition, but with all numbers in every column
 	{
-		--ptr;
-		--len;
-	}
+		bigunion.value = carry;
+		for (j = 0; j < count; j++)
+			if (i < nums[j].len)
+				bigunion.value += (ull)nums[j].vals[i];	// Add i-th word of every number that is long enough
 
-	big->len = len; // set new length
+		dest.vals[i] = bigunion.svals.low;	// low word of sum is result
+		carry = bigunion.svals.high;		// high word of sum is carry
+	}
+	dest.vals[len] = (ul)carry;	// put carry in MSW of result
+	bigtrim(&dest);				// Trim leading 0s from result
+	*res = dest;
 }
 
-
 /*
- *	Read BigInt from string in given base
+ *	Subtract two BigInts, a must not be smaller than b
  */
-void stobig(char* str, ul base, BigInt* res)
+void bigsub(BigInt* a, BigInt* b, BigInt* res)
 {
-	BigInt dest, digit, b, tmp;
-	ul digit_value;
+	BigInt dest;
+	long len;
+	long long diff;
 
-	digit.vals = &digit_value;	// Make 1 word BigInt to sore digit in it
-	digit.len = 1;
+	if (bigcmp(a, b) < 0) // Result would be negative
+	{
+		fprintf(stderr, "Result of subtraction is negative!\n");
+		longjmp(exception, 1);
+	}
+
+	// Result will be at most as long as a
+	dest.len = a->len;
+	dest.vals = alloc(dest.len);
 
-	b.vals = &base;	// Make 1 word BigInt to sore base in it
-	b.len = 1;
+	// Helper variables
+	long long borrow = 0;
+	register ul* dest_ptr = dest.vals;
+	register ul* a_ptr = a->vals;
+	register ul* b_ptr = b->vals;
 
-	dest = _zero; // Init dest as 0
-	// Convert string to number using Horner's method
-	while (*str)
+	len = b->len;
+	while (len--) // Column subtraction
 	{
-		digit_value = *str++; // Get char from input string
-
-		// Translate char to its numerical value
-		if ((digit_value >= '0') && (digit_value <= '9'))
-			digit_value -= 48;
-		else if ((digit_value >= 'a') && (digit_value <= 'f'))
-			digit_value -= 87;
-		else if ((digit_value >= 'A') && (digit_value <= 'F'))
-			digit_value -= 55;
-		else // Invalid character passed as digit
-		{
-			fprintf(stderr, "Character '%c' is not a digit!\n", digit_value);
-			longjmp(exception, 1);
-		}
-
-		if (digit_value >= base) // Check whether digit fits in given base
-		{
-			fprintf(stderr, "Digit '%ld' is to big for base (%ld)!\n", digit_value, base);
-			longjmp(exception, 1);
-		}
-
-		// Multiply by base and add digit
-		bigmul(&dest, &b, &tmp);
-		freeval(dest);
-		bigadd(&tmp, &digit, &dest);
-		freeval(tmp);
+		diff = (long long)*a_ptr++ - *b_ptr++ - borrow;	// Subtract `b` word and borrow from `a` word
+		*dest_ptr++ = (ul)diff;							// low word of difference is result
+		borrow = diff < 0;								// borrow if difference is negative
 	}
 
-	// Trim leading 0s from result
-	bigtrim(&dest);
+	// b ended, we now only subtract borrow from a
+	len = a->len - b->len;
+	while (len--)
+	{
+		diff = (long long)*a_ptr++ - borrow;	// Subtract borrow from `a` word
+		*dest_ptr++ = (ul)diff;					// low word of difference is result
+		borrow = diff < 0;						// borrow if difference is negative
+	}
+	bigtrim(&dest);	// Trim leading 0s from result
 	*res = dest;
 }
 
-size_t n;
-size_t new_lineptr_len;
-char* num, * cur_pos, * new_num;
+/*
+ *	Compare two BigInts, returns -1, 0 or 1 if a is smaller, equal or bigger than b
+ */
+int bigcmp(BigInt* a, BigInt* b)
+{
+	if (a->len != b->len) // Trimmed numbers of different length
+		return a->len > b->len ? 1 : -1;
+
+	for (long i = a->len - 1; i >= 0; i--) // Compare from MSW to LSW
+		if (a->vals[i] != b->vals[i])
+			return a->vals[i] > b->vals[i] ? 1 : -1;
+
+	return 0;
+}
 
 /*
- *	Print BigInt to given file
+ *	Get number of significant bits of BigInt
  */
-void bigprint(BigInt* big, ul basev, FILE* result)
+long bigbitlen(BigInt* big)
 {
-	char c;
-	BigInt a, base, quo, rem;
+	long nobits = (big->len - 1) * 32;
+	ul msw = big->vals[big->len - 1];
+	while (msw)	// count number of bits of MSW
+	{
+		nobits++;
+		msw >>= 1;
+	}
 
-	base.vals = &basev;	// Make 1 word BigInt to sore base in it
-	base.len = 1;
+	return nobits;
+}
 
+/*
+ *	Trim leading zeros of number 
+ */
+void bigtrim(BigInt* big)
+{
+	register ul* ptr = big->vals + big->len - 1;
 	long len = big->len;
-	if ((len == 1) && (*big->vals < basev)) // Check whether the number is already a digit
+	while (*ptr == 0 && len > 1)  // Traverse `vals` from MSW to LSW and decrease `len` until nonzero word hit, effectively shrinking the `vals` array
 	{
-		c = digitc(*big->vals);	// Get digit character
-		fputc(c, result);		// Print digit
-		fputc('\n', result);
-		return;
+		--ptr;
+		--len;
 	}
 
-	bigcpy(big, &a);	// Make local copy of number as it will be modified
+	big->len = len; // set new length
+}
+
 
-	if (num == NULL)	// Allocate output buffer is needed, we need it because we find digits from right to left but print from left to right
+/*
+ *	Translate digit character to its numerical value in given base
+ */
+ul digitval(char c, ul base)
+{
+	ul digit_value = c;
+
+	// Translate char to its numerical value
+	if ((digit_value >= '0') && (digit_value <= '9'))
+		digit_value -= 48;
+	else if ((digit_value >= 'a') && (digit_value <= 'f'))
+		digit_value -= 87;
+	else if ((digit_value >= 'A') && (digit_value <= 'F'))
+		digit_value -= 55;
+	else // Invalid character passed as digit
 	{
-		n = 128;		// Make it 128 characters long and try to alloc
-		if ((num = (char*)malloc(n)) == NULL)
-		{
-			fprintf(stderr, "Could not allocate memory for number!");
-			longjmp(exception, 1);
-		}
+		fprintf(stderr, "Character '%c' is not a digit!\n", c);
+		longjmp(exception, 1);
 	}
 
-	cur_pos = num;
-	while (a.len > 1 || a.vals[0])
+	if (digit_value >= base) // Check whether digit fits in given base
 	{
-		if ((num + n - cur_pos) < 2)	// The output buffer is to small to contain another digit
-		{
-			if (MAXSSIZE_T / 2 < n)		// Hard limit for max buffer size = MAXSSIZE_T
-			{	
-				fprintf(stderr, "The number is too big to print!");
-				longjmp(exception, 1);
-			}
-
-			new_lineptr_len = n * 2;	// Double the length and try reallocing
-			if ((new_num = (char*)realloc(num, new_lineptr_len)) == NULL)
-			{
-				fprintf(stderr, "Could not allocate memory for number!");
-				longjmp(exception, 1);
-			}
-
-			cur_pos = new_num + (cur_pos - num);	// Recalculate pointer
-			num = new_num;
-			n = new_lineptr_len;
-		}
-
-		bigdiv(&a, &base, &quo, &rem);	// Divide number by base, the remainder is digit
-		c = digitc(rem.vals[0]);		// Get digit char
-		*cur_pos++ = c;					// Add the char at the end
-		freeval(a);		// We can dispose of a
-		freeval(rem);	// We can dispose of remainder
-		a = quo;		// Quotient is our new a
+		fprintf(stderr, "Digit '%ld' is to big for base (%ld)!\n", digit_value, base);
+		longjmp(exception, 1);
 	}
 
-	// Number must be reversed so print from the end
-	while (cur_pos > num)
+	return digit_value;
+}
+
+/*
+ *	Read BigInt from string in given base, k digits at once (see radixlimb)
+ */
+void stobig(char* str, ul base, BigInt* res)
+{
+	BigInt radix;
+
+	storadix(str, base, &radix);
+	radixtobig(&radix, base, res);
+	freeval(radix);
+}
+
+/*
+ *	Validate number string in given base and bring it to the form bigprint would print it in
+ *	(uppercase digits, no leading zeros). Returns pointer to first significant digit
+ */
+char* strnorm(char* str, ul base)
+{
+	ul digit_value;
+
+	for (char* ptr = str; *ptr; ptr++)
 	{
-		fputc(*--cur_pos, result);
+		digit_value = digitval(*ptr, base);
+		*ptr = digitc(digit_value);	// Make letters uppercase
 	}
-	fputc('\n', result);
-	freeval(a);
+
+	while (*str == '0' && str[1])	// Skip leading zeros, but keep the last digit
+		str++;
+
+	return *str ? str : "0";	// Empty string is read as zero
 }
 
 /*
- *	Free number buffer 
+ *	Print BigInt to given output, k digits at once (see radixlimb)
+ */
+void bigprint(BigInt* big, ul base, Output* result)
+{
+	BigInt radix;
+
+	bigtoradix(big, base, &radix);
+	radixprint(&radix, base, result);
+	freeval(radix);
+}
+
+/*
+ *	Free cached divisors
  */
 void cleanup(void)
 {
-	free(num);
-}
\ No newline at end of file
+	divcleanup();
+}
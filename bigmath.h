@@ -8,6 +8,7 @@
 #include <limits.h>
 
 #include "utils.h"
+#include "output.h"
 
 /*
  *	Useful macros
@@ -20,6 +21,11 @@
 #define isone(big)			(((big).len == 1) && (*(big).vals == 1))
 #define isleqone(big)		(((big).len == 1) && (*(big).vals <= 1))
 
+/*
+ *	Numbers of at most that many words are added and multiplied by unrolled kernels
+ */
+#define SMALL_LIMIT			8
+
 #define digitc(dig)			(((dig <= 9) ? '0' : 55) + dig)
 
 /*
@@ -33,6 +39,16 @@ typedef struct {
 	long	len;
 } BigInt;
 
+/*
+ *	Divisor prepared for repeated division
+ */
+typedef struct {
+	BigInt	divisor;	// Original divisor
+	ul*		vals;		// Normalized divisor (shifted left, so that MSb is 1)
+	short	shift;		// Number of bits divisor was shifted by
+	ul		inv;		// Reciprocal of normalized MSW
+} BigDivisor;
+
 /*
  *	Quick way to split uul into high ul and low ul without shifts
  */
@@ -56,21 +72,63 @@ ul* alloc(long len);
 void bigcpy(BigInt* from, BigInt* to);
 
 void bigadd(BigInt* a, BigInt* b, BigInt* res);
+void bigsum(BigInt* nums, long count, BigInt* res);
+void bigsub(BigInt* a, BigInt* b, BigInt* res);
+int bigcmp(BigInt* a, BigInt* b);
+long bigbitlen(BigInt* big);
+
+void smalladd(BigInt* a, BigInt* b, ul* dest);
+void smallmul(BigInt* a, BigInt* b, ul* dest);
 
 void bigmul(BigInt* a, BigInt* b, BigInt* res);
+void bigprod(BigInt* nums, long count, BigInt* res);
 
 void bigdiv(BigInt* a, BigInt* b, BigInt* quo, BigInt* rem);
+void bigdivprep(BigInt* v, BigDivisor* d);
+void bigdivpre(BigInt* u, BigDivisor* d, BigInt* quo, BigInt* rem);
+void bigdivfree(BigDivisor* d);
 void bigquo(BigInt* a, BigInt* b, BigInt* res);
 void bigmod(BigInt* a, BigInt* b, BigInt* res);
 
+void biggcd(BigInt* a, BigInt* b, BigInt* res);
+void biginv(BigInt* a, BigInt* m, BigInt* res);
+
 void bigsqr(BigInt* big, BigInt* res);
 void bigpow(BigInt* a, BigInt* b, BigInt* res);
 
+void bigsqrt(BigInt* a, BigInt* res);
+void bigroot(BigInt* a, BigInt* b, BigInt* res);
+
+ul shlwords(ul* RESTRICT dst, const ul* RESTRICT src, long len, short shift);
+void shrwords(ul* RESTRICT dst, const ul* RESTRICT src, long len, short shift);
+void bigshl(BigInt* a, BigInt* b, BigInt* res);
+void bigshr(BigInt* a, BigInt* b, BigInt* res);
+void bigand(BigInt* a, BigInt* b, BigInt* res);
+void bigor(BigInt* a, BigInt* b, BigInt* res);
+void bigxor(BigInt* a, BigInt* b, BigInt* res);
+
+void bigfact(BigInt* a, BigInt* res);
+void bigbinom(BigInt* a, BigInt* b, BigInt* res);
+
 void bigtrim(BigInt* big);
 
+ul digitval(char c, ul base);
 void stobig(char* str, ul base, BigInt* result);
-void bigprint(BigInt* big, ul base, FILE* result);
-
+char* strnorm(char* str, ul base);
+void bigprint(BigInt* big, ul base, Output* result);
+
+ul radixlimb(ul base, short* digits);
+void storadix(char* str, ul base, BigInt* res);
+void radixprint(BigInt* big, ul base, Output* result);
+void radixtobig(BigInt* a, ul base, BigInt* res);
+void bigtoradix(BigInt* a, ul base, BigInt* res);
+void radixadd(BigInt* a, BigInt* b, ul base, BigInt* res);
+void radixsum(BigInt* nums, long count, ul base, BigInt* res);
+void radixmul(BigInt* a, BigInt* b, ul base, BigInt* res);
+void radixprod(BigInt* nums, long count, ul base, BigInt* res);
+void radixpow(BigInt* a, BigInt* b, ul base, BigInt* res);
+
+void divcleanup(void);
 void cleanup(void);
 
 #endif /* !BIGMATH_H */
\ No newline at end of file
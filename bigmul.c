@@ -27,6 +27,14 @@ void bigmul(BigInt* a, BigInt* b, BigInt* res)
 	dest.len = a->len + b->len;		// Result will be at most a.len + b.len long
 	dest.vals = alloc(dest.len);
 
+	if (a->len <= SMALL_LIMIT && b->len <= SMALL_LIMIT) // Short numbers, use unrolled kernel
+	{
+		smallmul(a, b, dest.vals);
+		dest.len -= dest.vals[dest.len - 1] == 0;	// Product of nonzero numbers has at most one leading zero word
+		*res = dest;
+		return;
+	}
+
 	ull carry = 0;
 	register ul* dest_ptr = dest.vals;
 	register ul* a_ptr = a->vals;
@@ -63,6 +71,34 @@ void bigmul(BigInt* a, BigInt* b, BigInt* res)
 	*res = dest;
 }
 
+/*
+ *	Multiply any number of BigInts using balanced product tree
+ */
+void bigprod(BigInt* nums, long count, BigInt* res)
+{
+	BigInt left, right;
+
+	switch (count)
+	{
+	case 0:		// Empty product
+		*res = _one;
+		return;
+	case 1:		// Only one factor, copy it to result
+		bigcpy(nums, res);
+		return;
+	case 2:		// Two factors, just multiply them
+		bigmul(nums, nums + 1, res);
+		return;
+	}
+
+	// Multiply both halves separately, so that factors in every multiplication are of similar size
+	bigprod(nums, count / 2, &left);
+	bigprod(nums + count / 2, count - count / 2, &right);
+	bigmul(&left, &right, res);
+	freeval(left);
+	freeval(right);
+}
+
 /*
  *	Square BigInt
  */
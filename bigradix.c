@@ -0,0 +1,405 @@
+#include "bigmath.h"
+
+/*
+ *	Numbers in radix representation keep k digits of given base in every word (limb),
+ *	so that they can be read and printed in linear time. BigInt with such limbs is only
+ *	meaningful together with its base and must not be passed to binary operations
+ */
+
+/*
+ *	Limbs are kept below this bound, so that radixmul can add several limb products to a 64-bit column before propagating carries
+ */
+#define RADIX_LIMIT	(1UL << 31)
+
+/*
+ *	Get biggest power of base smaller than RADIX_LIMIT (limb), its exponent is stored in digits
+ */
+ul radixlimb(ul base, short* digits)
+{
+	ul limb = 1;
+	short k = 0;
+
+	while ((ull)limb * base < RADIX_LIMIT)
+	{
+		limb *= base;
+		k++;
+	}
+
+	*digits = k;
+	return limb;
+}
+
+/*
+ *	Read number in radix representation from string in given base, every limb takes k digits from the end
+ */
+void storadix(char* str, ul base, BigInt* res)
+{
+	BigInt dest;
+	short k;
+	size_t len = strlen(str);
+	ul limb;
+
+	radixlimb(base, &k);
+
+	if (len == 0) // Empty string is read as zero
+	{
+		*res = _zero;
+		return;
+	}
+
+	dest.len = (long)((len + k - 1) / k);
+	dest.vals = alloc(dest.len);
+
+	for (long i = 0; i < dest.len; i++)
+	{
+		char* end = str + len - (size_t)i * k;
+		char* start = end - str > k ? end - k : str;
+
+		limb = 0;
+		while (start < end)	// Horner's method within one limb
+			limb = limb * base + digitval(*start++, base);
+		dest.vals[i] = limb;
+	}
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Print number in radix representation to given output, every limb but the most significant one gives exactly k digits
+ */
+void radixprint(BigInt* big, ul base, Output* result)
+{
+	char digits[sizeof(ul) * CHAR_BIT];
+	char* cur_pos;
+	ul limb;
+	short k;
+
+	radixlimb(base, &k);
+
+	for (long i = big->len - 1; i >= 0; i--)
+	{
+		limb = big->vals[i];
+		cur_pos = digits + k;
+
+		if (i == big->len - 1) // Leading limb, no leading zeros but at least one digit
+		{
+			do
+			{
+				*--cur_pos = digitc(limb % base);
+				limb /= base;
+			} while (limb);
+		}
+		else // Pad limb with zeros to k digits
+		{
+			while (cur_pos > digits)
+			{
+				*--cur_pos = digitc(limb % base);
+				limb /= base;
+			}
+		}
+
+		outwrite(result, cur_pos, digits + k - cur_pos);
+	}
+
+	outputc(result, '\n');
+}
+
+/*
+ *	Convert number from radix representation to binary, using Horner's method on limbs
+ */
+void radixtobig(BigInt* a, ul base, BigInt* res)
+{
+	BigInt dest;
+	BIGUNION bigunion;
+	short k;
+	ul limb = radixlimb(base, &k);
+
+	if (isleqone(*a)) // 0 and 1 are the same in both representations
+	{
+		bigcpy(a, res);
+		return;
+	}
+
+	// Every limb is smaller than a word, so binary number is not longer
+	dest.vals = alloc(a->len);
+	dest.vals[0] = a->vals[a->len - 1];
+	dest.len = 1;
+
+	for (long i = a->len - 2; i >= 0; i--)
+	{
+		ull carry = a->vals[i];
+		for (long j = 0; j < dest.len; j++)
+		{
+			bigunion.value = (ull)dest.vals[j] * limb + carry;	// Multiply word by limb value and add carry (next limb at first)
+			dest.vals[j] = bigunion.svals.low;					// low word is result
+			carry = bigunion.svals.high;						// high word is carry
+		}
+		if (carry)
+			dest.vals[dest.len++] = (ul)carry;	// put carry in new MSW
+	}
+
+	*res = dest;
+}
+
+/*
+ *	Convert binary number to radix representation, every division by limb value gives k digits at once
+ */
+void bigtoradix(BigInt* a, ul base, BigInt* res)
+{
+	BigInt dest, cur, quo, rem, divisor;
+	short k, nobits = 0;
+	ul limb = radixlimb(base, &k);
+
+	if (isleqone(*a)) // 0 and 1 are the same in both representations
+	{
+		bigcpy(a, res);
+		return;
+	}
+
+	ul msb = limb;
+	while (msb >>= 1)	// Every limb holds at least floor(log2(limb)) bits
+		nobits++;
+
+	if ((size_t)(LONG_MAX - 1) / 32 < (size_t)a->len)
+	{
+		fprintf(stderr, "The number is too big to convert!\n");
+		longjmp(exception, 1);
+	}
+
+	dest.len = (long)((size_t)a->len * 32 / nobits + 1);
+	dest.vals = alloc(dest.len);
+
+	divisor.vals = &limb;	// Make 1 word BigInt to store limb value in it
+	divisor.len = 1;
+
+	long i = 0;
+	bigcpy(a, &cur);
+	while (!iszero(cur))
+	{
+		bigdiv(&cur, &divisor, &quo, &rem);	// Remainder is next limb
+		dest.vals[i++] = rem.vals[0];
+		freeval(rem);
+		freeval(cur);
+		cur = quo;
+	}
+	freeval(cur);
+
+	dest.len = i;
+	*res = dest;
+}
+
+/*
+ *	Add any number of numbers in radix representation in one pass
+ */
+void radixsum(BigInt* nums, long count, ul base, BigInt* res)
+{
+	BigInt dest;
+	long len = 1, i, j;
+	short k;
+	ul limb = radixlimb(base, &k);
+
+	for (j = 0; j < count; j++) // Find length of the longest number
+		if (nums[j].len > len)
+			len = nums[j].len;
+
+	// Carry stays below count, so result will be at most 1 longer than the longest number
+	dest.len = len + 1;
+	dest.vals = alloc(dest.len);
+
+	ull carry = 0;
+	for (i = 0; i < len; i++) // Column addition, but with all numbers in every column
+	{
+		for (j = 0; j < count; j++)
+			if (i < nums[j].len)
+				carry += nums[j].vals[i];	// Add i-th limb of every number that is long enough
+
+		dest.vals[i] = (ul)(carry % limb);	// Sum modulo limb value is result
+		carry /= limb;						// The rest is carry
+	}
+	dest.vals[len] = (ul)carry;	// put carry in MS limb of result
+	bigtrim(&dest);				// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Add two numbers in radix representation
+ */
+void radixadd(BigInt* a, BigInt* b, ul base, BigInt* res)
+{
+	BigInt pair[2];
+
+	pair[0] = *a;
+	pair[1] = *b;
+	radixsum(pair, 2, base, res);
+}
+
+/*
+ *	Propagate carries of limb products accumulated in 64-bit columns, starting at column start.
+ *	Columns from end on are normalized already, so carry propagation stops there as soon as there is no carry
+ */
+static void radixcarry(ull* cols, long start, long end, long len, ul limb)
+{
+	ull carry = 0;
+
+	for (long i = start; i < len && (i < end || carry); i++)
+	{
+		cols[i] += carry;
+		carry = cols[i] / limb;
+		cols[i] %= limb;
+	}
+}
+
+/*
+ *	Multiply two numbers in radix representation. Limb products are accumulated in 64-bit columns
+ *	and carries are propagated only when columns could overflow, instead of dividing after every product
+ */
+void radixmul(BigInt* a, BigInt* b, ul base, BigInt* res)
+{
+	BigInt dest;
+	ull* cols;
+	short k;
+	ul limb = radixlimb(base, &k);
+
+	if (iszero(*a) || iszero(*b))	// Either is zero, return zero
+	{
+		*res = _zero;
+		return;
+	}
+	else if (isone(*a))	// a is one, so we copy b to result
+	{
+		bigcpy(b, res);
+		return;
+	}
+	else if (isone(*b))	// b is one, so we copy a to result
+	{
+		bigcpy(a, res);
+		return;
+	}
+
+	// Number of rows that can be added to normalized columns, leaving room for carry of normalization
+	const ull maxlimb = limb - 1;
+	const ull maxrows = (ULLONG_MAX - maxlimb - ULLONG_MAX / limb - 1) / (maxlimb * maxlimb);
+
+	dest.len = a->len + b->len;		// Result will be at most a.len + b.len long
+	if ((cols = (ull*)calloc(dest.len, sizeof(ull))) == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory for product!\n");
+		longjmp(exception, 1);
+	}
+
+	ull rows = 0;
+	for (long i = 0; i < a->len; i++)
+	{
+		if (rows == maxrows) // Columns are full, normalize the ones touched by pending rows
+		{
+			radixcarry(cols, i - (long)rows, i + b->len, dest.len, limb);
+			rows = 0;
+		}
+
+		// Add every limb of b multiplied by i-th limb of a to its column
+		const ull ai = a->vals[i];
+		for (long j = 0; j < b->len; j++)
+			cols[i + j] += ai * b->vals[j];
+		rows++;
+	}
+	radixcarry(cols, a->len - (long)rows, dest.len, dest.len, limb);
+
+	dest.vals = alloc(dest.len);
+	for (long i = 0; i < dest.len; i++)
+		dest.vals[i] = (ul)cols[i];
+	free(cols);
+
+	bigtrim(&dest);	// Trim leading 0s from result
+	*res = dest;
+}
+
+/*
+ *	Multiply any number of numbers in radix representation using balanced product tree
+ */
+void radixprod(BigInt* nums, long count, ul base, BigInt* res)
+{
+	BigInt left, right;
+
+	switch (count)
+	{
+	case 0:		// Empty product
+		*res = _one;
+		return;
+	case 1:		// Only one factor, copy it to result
+		bigcpy(nums, res);
+		return;
+	case 2:		// Two factors, just multiply them
+		radixmul(nums, nums + 1, base, res);
+		return;
+	}
+
+	// Multiply both halves separately, so that factors in every multiplication are of similar size
+	radixprod(nums, count / 2, base, &left);
+	radixprod(nums + count / 2, count - count / 2, base, &right);
+	radixmul(&left, &right, base, res);
+	freeval(left);
+	freeval(right);
+}
+
+/*
+ *	Exponentiate number in radix representation, exponent is in radix representation too
+ */
+void radixpow(BigInt* a, BigInt* b, ul base, BigInt* res)
+{
+	BigInt dest, sqr, tmp, exp;
+
+	// Constant results
+	if (iszero(*a))		// 0^k
+	{
+		if (iszero(*b))	// 0^0 - undefined
+		{
+			fprintf(stderr, "Zero to zeroth power is undefined!\n");
+			longjmp(exception, 1);
+		}
+
+		*res = _zero;
+		return;
+	}
+	else if (iszero(*b) || isone(*a))	// k^0 = 1 or 1^k = 1
+	{
+		*res = _one;
+		return;
+	}
+
+	radixtobig(b, base, &exp);
+	if (exp.len > 1)	// Only allow for one-word exponents
+	{
+		freeval(exp);
+		fprintf(stderr, "Exponent is to big!\n");
+		longjmp(exception, 1);
+	}
+
+	ul exponent = exp.vals[0];	// Store exponent locally
+	freeval(exp);
+
+	// Exponentiation by squaring
+	bigcpy(a, &sqr);
+	dest = _one;
+
+	for (;;)
+	{
+		if (exponent % 2)	// Exponent is odd - multiply dest by sqr
+		{
+			radixmul(&dest, &sqr, base, &tmp);
+			freeval(dest);
+			dest = tmp;
+		}
+
+		exponent /= 2;
+		if (!exponent)	// Last square would not be used
+			break;
+
+		radixmul(&sqr, &sqr, base, &tmp);
+		freeval(sqr);
+		sqr = tmp;
+	}
+
+	freeval(sqr);
+	*res = dest;
+}
@@ -0,0 +1,115 @@
+#include "bigmath.h"
+
+/*
+ *	Integer n-th root (floor) using Newton iteration.
+ *	Starting estimate is root of leading half of bits, so every recursion level doubles precision
+ *	and only few Newton steps are done with full size numbers
+ */
+static void rootword(BigInt* a, ul n, BigInt* res)
+{
+	BigInt x, y, top, t, q, tmp;
+	BigInt word, index, index1, shiftbig;
+	ul n1 = n - 1, shift;
+	long bits, s;
+
+	if (isleqone(*a) || n == 1) // 0, 1 and first roots are number itself
+	{
+		bigcpy(a, res);
+		return;
+	}
+
+	bits = bigbitlen(a);
+	if ((ul)bits <= n) // a < 2^n, so root is 1
+	{
+		*res = _one;
+		return;
+	}
+
+	index.vals = &n;		// Make 1 word BigInts to store n and n - 1 in them
+	index.len = 1;
+	index1.vals = &n1;
+	index1.len = 1;
+	shiftbig.vals = &shift;	// and shift amount
+	shiftbig.len = 1;
+
+	// Estimate root from above
+	s = bits / (2 * n);
+	if (s > 0) // Take root of leading half of bits, shifting a right by n*s bits. (r + 1) * 2^s is at least root
+	{
+		shift = n * s;
+		bigshr(a, &shiftbig, &top);
+		rootword(&top, n, &tmp);
+		freeval(top);
+		bigadd(&tmp, &_one, &t);
+		freeval(tmp);
+
+		shift = s;
+		bigshl(&t, &shiftbig, &x);
+		freeval(t);
+	}
+	else // Number has less than 2n bits, 2^ceil(bits/n) is at least root (and at most 4)
+	{
+		bits = (bits + n - 1) / n;
+		x.len = bits / 32 + 1;
+		x.vals = alloc(x.len);
+		memset(x.vals, 0, x.len * sizeof(ul));
+		x.vals[x.len - 1] = (ul)1 << (bits % 32);
+	}
+
+	// Newton iteration from above: x = ((n-1)x + a / x^(n-1)) / n, until it stops decreasing
+	for (;;)
+	{
+		if (n == 2)	// Square root, x^(n-1) is just x
+		{
+			bigquo(a, &x, &q);
+		}
+		else
+		{
+			bigpow(&x, &index1, &t);
+			bigquo(a, &t, &q);
+			freeval(t);
+		}
+
+		word.vals = &n1;
+		word.len = 1;
+		bigmul(&x, &word, &t);
+		bigadd(&t, &q, &tmp);
+		freeval(t);
+		freeval(q);
+		bigquo(&tmp, &index, &y);
+		freeval(tmp);
+
+		if (bigcmp(&y, &x) >= 0)	// Estimate stopped decreasing, x is the root
+		{
+			freeval(y);
+			break;
+		}
+
+		freeval(x);
+		x = y;
+	}
+
+	*res = x;
+}
+
+/*
+ *	Integer square root (floor)
+ */
+void bigsqrt(BigInt* a, BigInt* res)
+{
+	rootword(a, 2, res);
+}
+
+/*
+ *	Integer b-th root of a (floor)
+ */
+void bigroot(BigInt* a, BigInt* b, BigInt* res)
+{
+	if (iszero(*b))
+	{
+		fprintf(stderr, "Zeroth root is undefined!\n");
+		longjmp(exception, 1);
+	}
+
+	rootword(a, b->len > 1 ? ULONG_MAX : b->vals[0], res);	// Index bigger than one word means root is 0 or 1 anyway
+}
\ No newline at end of file
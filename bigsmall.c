@@ -0,0 +1,110 @@
+#include "bigmath.h"
+
+/*
+ *	Fully unrolled kernels for numbers of at most SMALL_LIMIT words, generated for every length (pair of lengths).
+ *	Lengths are known at compile time, so there are no loops, length checks or pointer bookkeeping left
+ */
+
+/*
+ *	Repetition macros, m(i, x) is expanded for i = 0 .. n-1. There are two families, so that they can be nested
+ */
+#define ROW1(m, x)	m(0, x)
+#define ROW2(m, x)	ROW1(m, x) m(1, x)
+#define ROW3(m, x)	ROW2(m, x) m(2, x)
+#define ROW4(m, x)	ROW3(m, x) m(3, x)
+#define ROW5(m, x)	ROW4(m, x) m(4, x)
+#define ROW6(m, x)	ROW5(m, x) m(5, x)
+#define ROW7(m, x)	ROW6(m, x) m(6, x)
+#define ROW8(m, x)	ROW7(m, x) m(7, x)
+
+#define COL1(m, x)	m(x, 0)
+#define COL2(m, x)	COL1(m, x) m(x, 1)
+#define COL3(m, x)	COL2(m, x) m(x, 2)
+#define COL4(m, x)	COL3(m, x) m(x, 3)
+#define COL5(m, x)	COL4(m, x) m(x, 4)
+#define COL6(m, x)	COL5(m, x) m(x, 5)
+#define COL7(m, x)	COL6(m, x) m(x, 6)
+#define COL8(m, x)	COL7(m, x) m(x, 7)
+
+/*
+ *	Addition of two n word numbers, result has n + 1 words
+ */
+#define ADDWORD(i, _)	bigunion.value = (ull)a[i] + b[i] + carry;	/* Add `a` word + `b` word + carry */	\
+						dest[i] = bigunion.svals.low;				/* low word of sum is result */			\
+						carry = bigunion.svals.high;				/* high word of sum is carry */
+
+#define ADDKERNEL(n)																\
+static void add##n(const ul* RESTRICT a, const ul* RESTRICT b, ul* RESTRICT dest)	\
+{																					\
+	BIGUNION bigunion;																\
+	ull carry = 0;																	\
+	ROW##n(ADDWORD, _)																\
+	dest[n] = (ul)carry;															\
+}
+
+ADDKERNEL(1) ADDKERNEL(2) ADDKERNEL(3) ADDKERNEL(4) ADDKERNEL(5) ADDKERNEL(6) ADDKERNEL(7) ADDKERNEL(8)
+
+static void (* const addkernels[SMALL_LIMIT])(const ul* RESTRICT, const ul* RESTRICT, ul* RESTRICT) = {
+	add1, add2, add3, add4, add5, add6, add7, add8
+};
+
+/*
+ *	Multiplication of m word number by n word number, result has m + n words.
+ *	Every row adds `b` multiplied by one word of `a` to the result, its carry is the next word of the result
+ */
+#define ZEROWORD(i, _)	dest[i] = 0;
+
+#define MULWORD(i, j)	bigunion.value = (ull)a[i] * b[j] + dest[i + j] + carry;	/* Add `a` word * `b` word + `dest` word + carry */	\
+						dest[i + j] = bigunion.svals.low;							/* low word of sum is result */						\
+						carry = bigunion.svals.high;								/* high word of sum is carry */
+
+#define MULROW(i, n)	carry = 0;					\
+						COL##n(MULWORD, i)			\
+						dest[i + n] = (ul)carry;	/* put carry in next word of result */
+
+#define MULKERNEL(m, n)																	\
+static void mul##m##x##n(const ul* RESTRICT a, const ul* RESTRICT b, ul* RESTRICT dest)	\
+{																						\
+	BIGUNION bigunion;																	\
+	ull carry;																			\
+	ROW##n(ZEROWORD, _)																	\
+	ROW##m(MULROW, n)																	\
+}
+
+#define MULKERNELS(m)	MULKERNEL(m, 1) MULKERNEL(m, 2) MULKERNEL(m, 3) MULKERNEL(m, 4)	\
+						MULKERNEL(m, 5) MULKERNEL(m, 6) MULKERNEL(m, 7) MULKERNEL(m, 8)
+
+MULKERNELS(1) MULKERNELS(2) MULKERNELS(3) MULKERNELS(4) MULKERNELS(5) MULKERNELS(6) MULKERNELS(7) MULKERNELS(8)
+
+#define MULTABLE(m)	{ mul##m##x1, mul##m##x2, mul##m##x3, mul##m##x4, mul##m##x5, mul##m##x6, mul##m##x7, mul##m##x8 }
+
+static void (* const mulkernels[SMALL_LIMIT][SMALL_LIMIT])(const ul* RESTRICT, const ul* RESTRICT, ul* RESTRICT) = {
+	MULTABLE(1), MULTABLE(2), MULTABLE(3), MULTABLE(4), MULTABLE(5), MULTABLE(6), MULTABLE(7), MULTABLE(8)
+};
+
+/*
+ *	Add two numbers of at most SMALL_LIMIT words, b must not be longer than a. Result has a.len + 1 words
+ */
+void smalladd(BigInt* a, BigInt* b, ul* dest)
+{
+	ul padded[SMALL_LIMIT];
+
+	if (b->len < a->len) // Extend b with zeros to length of a
+	{
+		memcpy(padded, b->vals, b->len * sizeof(ul));
+		memset(padded + b->len, 0, (a->len - b->len) * sizeof(ul));
+		addkernels[a->len - 1](a->vals, padded, dest);
+	}
+	else
+	{
+		addkernels[a->len - 1](a->vals, b->vals, dest);
+	}
+}
+
+/*
+ *	Multiply two numbers of at most SMALL_LIMIT words. Result has a.len + b.len words
+ */
+void smallmul(BigInt* a, BigInt* b, ul* dest)
+{
+	mulkernels[a->len - 1][b->len - 1](a->vals, b->vals, dest);
+}
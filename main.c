@@ -6,6 +6,37 @@
 #include "bigmath.h"
 
 #define LINE_LEN (256 * sizeof(char))
+#define NAME_LEN 64		// Keep in sync with width of name in header format
+
+/*
+ *	Growable list of operands, together with their digits as read from input
+ */
+typedef struct {
+	BigInt* vals;
+	size_t*	ends;		// End of each number in `text`
+	long	len;
+	long	cap;
+	char*	text;		// Normalized digits of all numbers, each followed by '\n'
+	size_t	textlen;
+	size_t	textcap;
+} BigList;
+
+/*
+ *	Named result of a job, kept in binary for later blocks
+ */
+typedef struct {
+	char	name[NAME_LEN];
+	BigInt	val;
+} Named;
+
+/*
+ *	Growable list of named results
+ */
+typedef struct {
+	Named*	vals;
+	long	len;
+	long	cap;
+} NameList;
 
 void fileopen(FILE** file, char const* name, char const* mode, char** line)
 {
@@ -18,8 +49,150 @@ void fileopen(FILE** file, char const* name, char const* mode, char** line)
 	}
 }
 
-void basechange(FILE* inptr, FILE* outptr, char* line, size_t* line_number, unsigned short from_base, unsigned short work_base, BigInt* a)
+/*
+ *	Find named result, name must exist
+ */
+BigInt* getname(NameList* names, char* name)
 {
+	for (long i = 0; i < names->len; i++)
+		if (strcmp(names->vals[i].name, name) == 0)
+			return &names->vals[i].val;
+
+	fprintf(stderr, "Unknown name: %s\n", name);
+	longjmp(exception, 1);
+}
+
+/*
+ *	Store result under given name, replacing previous value of that name. List takes ownership of value
+ */
+void setname(NameList* names, char* name, BigInt* val)
+{
+	long cap;
+	void* ptr;
+
+	for (long i = 0; i < names->len; i++)
+	{
+		if (strcmp(names->vals[i].name, name) == 0) // Name is reused, drop its old value
+		{
+			freeval(names->vals[i].val);
+			names->vals[i].val = *val;
+			return;
+		}
+	}
+
+	if (names->len == names->cap) // Make room for another name
+	{
+		cap = names->cap ? names->cap * 2 : 4;
+		if ((ptr = realloc(names->vals, cap * sizeof(Named))) == NULL)
+		{
+			fprintf(stderr, "Could not allocate memory for names!");
+			longjmp(exception, 1);
+		}
+		names->vals = (Named*)ptr;
+		names->cap = cap;
+	}
+
+	strcpy_s(names->vals[names->len].name, NAME_LEN, name);
+	names->vals[names->len++].val = *val;
+}
+
+/*
+ *	Append number to the list, keeping its digits for echoing. Digits are read in radix representation,
+ *	`$name` stands for named result, which is copied in binary
+ */
+void pushnum(BigList* nums, char* digits, unsigned short base, NameList* names)
+{
+	size_t len = strlen(digits) + 1;
+	size_t textcap;
+	long cap;
+	void* ptr;
+
+	if (nums->len == nums->cap) // Make room for another number
+	{
+		cap = nums->cap ? nums->cap * 2 : 4;
+		if ((ptr = realloc(nums->vals, cap * sizeof(BigInt))) == NULL)
+		{
+			fprintf(stderr, "Could not allocate memory for numbers!");
+			longjmp(exception, 1);
+		}
+		nums->vals = (BigInt*)ptr;
+
+		if ((ptr = realloc(nums->ends, cap * sizeof(size_t))) == NULL)
+		{
+			fprintf(stderr, "Could not allocate memory for numbers!");
+			longjmp(exception, 1);
+		}
+		nums->ends = (size_t*)ptr;
+		nums->cap = cap;
+	}
+
+	if (nums->textlen + len > nums->textcap) // Make room for digits
+	{
+		textcap = nums->textcap ? nums->textcap * 2 : LINE_LEN;
+		while (nums->textlen + len > textcap)
+			textcap *= 2;
+
+		if ((ptr = realloc(nums->text, textcap)) == NULL)
+		{
+			fprintf(stderr, "Could not allocate memory for numbers!");
+			longjmp(exception, 1);
+		}
+		nums->text = (char*)ptr;
+		nums->textcap = textcap;
+	}
+
+	if (*digits == '$')
+		bigcpy(getname(names, digits + 1), &nums->vals[nums->len]);
+	else
+		storadix(digits, base, &nums->vals[nums->len]);
+
+	memcpy(nums->text + nums->textlen, digits, len - 1);
+	nums->textlen += len;
+	nums->text[nums->textlen - 1] = '\n';
+	nums->ends[nums->len++] = nums->textlen;
+}
+
+/*
+ *	Write digits of i-th number of the list, as they were read
+ */
+void echonum(Output* out, BigList* nums, long i)
+{
+	size_t start = i ? nums->ends[i - 1] : 0;
+	outwrite(out, nums->text + start, nums->ends[i] - start);
+}
+
+/*
+ *	Check whether i-th number of the list is named result
+ */
+int isnamed(BigList* nums, long i)
+{
+	return nums->text[i ? nums->ends[i - 1] : 0] == '$';
+}
+
+/*
+ *	Convert numbers read in radix representation to binary, named results are binary already
+ */
+void tobinary(BigList* nums, unsigned short base)
+{
+	BigInt tmp;
+
+	for (long i = 0; i < nums->len; i++)
+	{
+		if (!isnamed(nums, i))
+		{
+			radixtobig(&nums->vals[i], base, &tmp);
+			freeval(nums->vals[i]);
+			nums->vals[i] = tmp;
+		}
+	}
+}
+
+void basechange(FILE* inptr, Output* outptr, Output* conptr, char* line, size_t* line_number, unsigned short from_base, unsigned short work_base, NameList* names, BigInt* a)
+{
+	char digits[LINE_LEN];
+	size_t len = 0;
+	int named = 0;
+
 	// Base validation
 	if (from_base < 2 || from_base > 16)
 	{
@@ -41,13 +214,22 @@ void basechange(FILE* inptr, FILE* outptr, char* line, size_t* line_number, unsi
 		if (fgets(line, 256, inptr) == NULL)
 		{
 			fprintf(stderr, "Unexpected EOF\n");
-			exit(0);
+			longjmp(exception, 1);	// Results of previous jobs are still written
 		}
 
-		if(i == 1) // Number line - strip '\n' and convert to number
+		if(i == 1) // Number line - strip '\n', keep digits and convert to number if base changes
 		{
 			strip(line);
-			stobig(line, from_base, a);
+			char* start = line[0] == '$' ? line : strnorm(line, from_base);
+			len = strlen(start);
+			memcpy(digits, start, len);
+			digits[len++] = '\n';
+
+			named = line[0] == '$';
+			if (named) // Named result, it is already in binary
+				bigcpy(getname(names, line + 1), a);
+			else if (from_base != work_base)
+				stobig(start, from_base, a);
 		}
 		else // Empty line expected
 		{
@@ -60,21 +242,95 @@ void basechange(FILE* inptr, FILE* outptr, char* line, size_t* line_number, unsi
 		}
 	}
 
-	// Verbose info to console
-	printf("%hu -> %hu\n", from_base, work_base);
-	bigprint(a, from_base, stdout);
-	putc('\n', stdout);
+	// Verbose info to console, unless in quiet mode
+	if (conptr != NULL)
+	{
+		outprintf(conptr, "%hu -> %hu\n", from_base, work_base);
+		outwrite(conptr, digits, len);
+		outputc(conptr, '\n');
+		outflush(conptr);	// Show operands before any errors of this job
+	}
 
-	// Print result to file 
-	fprintf(outptr, "%hu %hu\n\n", from_base, work_base);
-	bigprint(a, from_base, outptr);
-	fputc('\n', outptr);
-	bigprint(a, work_base, outptr);
-	fputc('\n', outptr);
+	// Print result to file, number in from_base is just echoed
+	outprintf(outptr, "%hu %hu\n\n", from_base, work_base);
+	outwrite(outptr, digits, len);
+	outputc(outptr, '\n');
+	if (named || from_base != work_base)
+		bigprint(a, work_base, outptr);
+	else
+		outwrite(outptr, digits, len);
+	outputc(outptr, '\n');
 }
 
-void evaluateop(char operation, BigInt* a, BigInt* b, BigInt* res)
+/*
+ *	Get number of operands of given operation, -1 means any positive number
+ */
+long oparity(char operation)
 {
+	switch (operation)
+	{
+	case 'S': // a + b + ... + z
+	case 'P': // a * b * ... * z
+		return -1;
+	case 'Q': // sqrt(a)
+	case '!': // a!
+		return 1;
+	default: // Other operations are binary, unknown ones are rejected by evaluateop
+		return 2;
+	}
+}
+
+/*
+ *	Check whether operation works on numbers in radix representation, other operations need them converted to binary
+ */
+int radixop(char operation)
+{
+	switch (operation)
+	{
+	case '+':
+	case '*':
+	case '^':
+	case 'S':
+	case 'P':
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+void evaluateradix(char operation, unsigned short base, BigInt* nums, long count, BigInt* res)
+{
+	BigInt* a = nums;
+	BigInt* b = nums + 1;
+
+	switch (operation)
+	{
+	case '+': // a + b
+		radixadd(a, b, base, res);
+		break;
+	case '*': // a * b
+		radixmul(a, b, base, res);
+		break;
+	case '^': // a ^ b
+		radixpow(a, b, base, res);
+		break;
+	case 'S': // a + b + ... + z
+		radixsum(nums, count, base, res);
+		break;
+	case 'P': // a * b * ... * z
+		radixprod(nums, count, base, res);
+		break;
+	default: // Operation has no radix implementation
+		fprintf(stderr, "Uknown operation: %c\n", operation);
+		longjmp(exception, 1);
+	}
+}
+
+void evaluateop(char operation, BigInt* nums, long count, BigInt* res)
+{
+	BigInt* a = nums;
+	BigInt* b = nums + 1;
+
 	switch (operation)
 	{
 	case '+': // a + b
@@ -92,72 +348,155 @@ void evaluateop(char operation, BigInt* a, BigInt* b, BigInt* res)
 	case '^': // a ^ b
 		bigpow(a, b, res);
 		break;
+	case 'G': // gcd(a, b)
+		biggcd(a, b, res);
+		break;
+	case 'I': // a ^ -1 mod b
+		biginv(a, b, res);
+		break;
+	case 'Q': // sqrt(a)
+		bigsqrt(a, res);
+		break;
+	case 'R': // a ^ (1/b)
+		bigroot(a, b, res);
+		break;
+	case '!': // a!
+		bigfact(a, res);
+		break;
+	case 'C': // a! / (b! (a-b)!)
+		bigbinom(a, b, res);
+		break;
+	case '&': // a and b
+		bigand(a, b, res);
+		break;
+	case '|': // a or b
+		bigor(a, b, res);
+		break;
+	case 'X': // a xor b
+		bigxor(a, b, res);
+		break;
+	case '<': // a << b
+		bigshl(a, b, res);
+		break;
+	case '>': // a >> b
+		bigshr(a, b, res);
+		break;
+	case 'S': // a + b + ... + z
+		bigsum(nums, count, res);
+		break;
+	case 'P': // a * b * ... * z
+		bigprod(nums, count, res);
+		break;
 	default: // Invalid operation
 		fprintf(stderr, "Uknown operation: %c\n", operation);
 		longjmp(exception, 1);
 	}
 }
 
-void calculation(FILE* inptr, FILE* outptr, char* line, size_t* line_number, char operation, unsigned short work_base, BigInt* a, BigInt* b, BigInt* res)
+void calculation(FILE* inptr, Output* outptr, Output* conptr, char* line, size_t* line_number, char operation, unsigned short work_base, char* name, BigList* nums, NameList* names, BigInt* res)
 {
-	// Structure validation: one empty line, number A, one empty line, number B, two empty lines
-	for (size_t i = 0; i < 6; ++i) {
+	long arity = oparity(operation);
+	int radix;
+
+	// Structure validation: one empty line, numbers each followed by one empty line, one more empty line
+	for (size_t i = 0; ; ++i) {
 		++*line_number;
 		// Get line
 		if (fgets(line, 256, inptr) == NULL)
 		{
 			fprintf(stderr, "Unexpected EOF\n");
-			exit(0);
+			longjmp(exception, 1);	// Results of previous jobs are still written
 		}
 
-		switch (i)
+		// Number line - strip '\n' and convert to number. Operations with any number of operands end on empty line instead
+		if (i % 2 == 1 && (arity < 0 ? (line[0] != '\n' || nums->len == 0) : nums->len < arity))
 		{
-		case 1: // Number A line - strip '\n' and convert to number
-			strip(line);
-			stobig(line, work_base, a);
-			break;
-		case 3: // Number B line - strip '\n' and convert to number
 			strip(line);
-			stobig(line, work_base, b);
-			break;
-		default: // Empty line expected
-			if (line[0] != '\n')
-			{
-				fprintf(stderr, "[%zu] Missing empty line!\n", *line_number);
+			pushnum(nums, line[0] == '$' ? line : strnorm(line, work_base), work_base, names);
+		}
+		else if (line[0] != '\n') // Empty line expected
+		{
+			fprintf(stderr, "[%zu] Missing empty line!\n", *line_number);
+			if (arity < 0)
+				fprintf(stderr, "Correct format: <operation> <base>\n\n<number>\n\n[<number>\n\n...]\n");
+			else if (arity == 1)
+				fprintf(stderr, "Correct format: <operation> <base>\n\n<number>\n\n\n");
+			else
 				fprintf(stderr, "Correct format: <operation> <base>\n\n<number>\n\n<number>\n\n\n");
-				longjmp(exception, 1);
-			}
+			longjmp(exception, 1);
+		}
+		else if (i % 2 == 1) // Second empty line after last number
+		{
+			break;
+		}
+	}
+
+	// Verbose info to console, unless in quiet mode
+	if (conptr != NULL)
+	{
+		if (name != NULL)
+			outprintf(conptr, "[%hu] = %s\n", work_base, name);
+		else
+			outprintf(conptr, "[%hu]\n", work_base);
+		echonum(conptr, nums, 0);
+		for (long i = 1; i < nums->len; i++)
+		{
+			outprintf(conptr, "%c\n", operation);
+			echonum(conptr, nums, i);
 		}
+		outputc(conptr, '\n');
+		outflush(conptr);	// Show operands before any errors of this job
 	}
 
-	// Verbose info to console
-	printf("[%hu]\n", work_base);
-	bigprint(a, work_base, stdout);
-	printf("%c\n", operation);
-	bigprint(b, work_base, stdout);
-	putc('\n', stdout);
+	// Named result is kept for later blocks and not printed at all
+	if (name != NULL)
+	{
+		tobinary(nums, work_base);
+		evaluateop(operation, nums->vals, nums->len, res);
+		setname(names, name, res);
+		*res = _zero;
+		return;
+	}
 
 	// Print beggining of result to file 
-	fprintf(outptr, "%c %hu\n\n", operation, work_base);
-	bigprint(a, work_base, outptr);
-	putc('\n', outptr);
-	bigprint(b, work_base, outptr);
-	putc('\n', outptr);
-
-	// Compute result
-	evaluateop(operation, a, b, res);
-
-	// Print actual result to file
-	bigprint(res, work_base, outptr);
-	putc('\n', outptr);
+	outprintf(outptr, "%c %hu\n\n", operation, work_base);
+	for (long i = 0; i < nums->len; i++)
+	{
+		echonum(outptr, nums, i);
+		outputc(outptr, '\n');
+	}
+
+	// Compute result and print it to file. Operands are in radix representation (named results in binary),
+	// they are converted to binary only if operation needs it
+	radix = radixop(operation);
+	for (long i = 0; i < nums->len; i++)
+		if (isnamed(nums, i))
+			radix = 0;
+
+	if (radix)
+	{
+		evaluateradix(operation, work_base, nums->vals, nums->len, res);
+		radixprint(res, work_base, outptr);
+	}
+	else
+	{
+		tobinary(nums, work_base);
+		evaluateop(operation, nums->vals, nums->len, res);
+		bigprint(res, work_base, outptr);
+	}
+	outputc(outptr, '\n');
 }
 
 int main(int argc, char** argv)
 {
 	FILE* inptr, * outptr;
+	Output out, con;
+	Output* conptr;
 	errno_t err;
 
+	char* inname = NULL;
 	char* outname = "result.txt";
+	int quiet = 0, async = 0;
 	char* line = (char*)malloc(LINE_LEN);
 	size_t len = 0;
 	size_t line_number = 0;
@@ -165,31 +504,46 @@ int main(int argc, char** argv)
 	unsigned short from_base;
 	char operation;
 	unsigned short work_base;
+	char name[NAME_LEN];
 	BigInt a = _zero;
-	BigInt b = _zero;
+	BigList nums = { NULL, NULL, 0, 0, NULL, 0, 0 };
+	NameList names = { NULL, 0, 0 };
 	BigInt res = _zero;
 
+	// Command line parsing: options followed by input and optional output file
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-q") == 0)		// Quiet mode - no verbose info to console
+			quiet = 1;
+		else if (strcmp(argv[i], "-a") == 0)	// Write output file from background thread
+			async = 1;
+		else if (inname == NULL)
+			inname = argv[i];
+		else
+			outname = argv[i];
+	}
+
 	// Command line validation
-	if (argc < 2)
+	if (inname == NULL)
 	{
-		fprintf(stderr, "Filename required! Usage: calculate <input> [output=result.txt]\n");
+		fprintf(stderr, "Filename required! Usage: calculate [-q] [-a] <input> [output=result.txt]\n");
 		return 0;
 	}
 
-	// Optional output file argument
-	if (argc == 3)
-		outname = argv[2];
-
 	// Input file initialization
-	fileopen(&inptr, argv[1], "r", &line);
+	fileopen(&inptr, inname, "r", &line);
 
 	// Output file initialization
 	fileopen(&outptr, outname, "w", &line);
+	conptr = quiet ? NULL : &con;	// Console output is skipped in quiet mode
+	if (!outopen(&out, outptr, async) || (conptr != NULL && !outopen(conptr, stdout, 0)))
+		return 0;
 
 	// Main program loop
 	while (fgets(line, 256, inptr) != NULL)
 	{
 		line_number++;
+		name[0] = '\0';	// Set by header of named job only
 
 		// Exception handling using <setjmp.h>
 		if (setjmp(exception) == 0)
@@ -197,9 +551,9 @@ int main(int argc, char** argv)
 			// Case 1: base conversion <from> <to>
 			if (sscanf_s(line, "%hu %hu", &from_base, &work_base) == 2)
 			{
-				basechange(inptr, outptr, line, &line_number, from_base, work_base, &a);
+				basechange(inptr, &out, conptr, line, &line_number, from_base, work_base, &names, &a);
 			}
-			else if (sscanf_s(line, "%c %hu", &operation, 1, &work_base) == 2) // Case 2: operation <op_symbol> <base>
+			else if (sscanf_s(line, "%c %hu = %63s", &operation, 1, &work_base, name, (unsigned)NAME_LEN) >= 2) // Case 2: operation <op_symbol> <base> [= <name>]
 			{
 				// Base validation
 				if (work_base < 2 || work_base > 16)
@@ -208,7 +562,7 @@ int main(int argc, char** argv)
 					continue;
 				}
 
-				calculation(inptr, outptr, line, &line_number, operation, work_base, &a, &b, &res);
+				calculation(inptr, &out, conptr, line, &line_number, operation, work_base, name[0] ? name : NULL, &nums, &names, &res);
 			}
 			else // Unknown line format
 			{
@@ -216,22 +570,34 @@ int main(int argc, char** argv)
 				fprintf(stderr, "[%zu] Cannot understand line: '%s'\n", line_number, line);
 			}
 		}
-		else // Exception detected either in structure or during computation
+		else if (!feof(inptr)) // Exception detected either in structure or during computation, input ending in the middle of a block only stops the loop
 		{
 			fprintf(stderr, "[%zu] An error occured during calculation!\n", line_number);
-			fprintf(outptr,"An error occured during calculation!\n");
+			if (name[0] == '\0')	// Named jobs have no block in output, their errors are reported to console only
+				outprintf(&out, "An error occured during calculation!\n");
 		}
 
 		// Free values
 		freeval(a);
-		freeval(b);
+		for (; nums.len > 0; nums.len--)
+			freeval(nums.vals[nums.len - 1]);
+		nums.textlen = 0;
 		freeval(res);
 	}
 
 	// Cleanup - close files and free memory
+	outclose(&out);
+	if (conptr != NULL)
+		outclose(conptr);
 	fclose(inptr);
 	fclose(outptr);
 	cleanup();
+	free(nums.vals);
+	free(nums.ends);
+	free(nums.text);
+	for (long i = 0; i < names.len; i++)
+		freeval(names.vals[i].val);
+	free(names.vals);
 	free(line);
 
 	return 0;
@@ -0,0 +1,264 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "output.h"
+
+/*
+ *	Thread synchronization primitives
+ */
+#if defined(_WIN32)
+#define outlock(out)	EnterCriticalSection(&(out)->lock)
+#define outunlock(out)	LeaveCriticalSection(&(out)->lock)
+#define outwait(out)	SleepConditionVariableCS(&(out)->cond, &(out)->lock, INFINITE)
+#define outwake(out)	WakeAllConditionVariable(&(out)->cond)
+#else
+#define outlock(out)	pthread_mutex_lock(&(out)->lock)
+#define outunlock(out)	pthread_mutex_unlock(&(out)->lock)
+#define outwait(out)	pthread_cond_wait(&(out)->cond, &(out)->lock)
+#define outwake(out)	pthread_cond_broadcast(&(out)->cond)
+#endif
+
+/*
+ *	Writer thread body - write submitted blocks to file until output is closed
+ */
+static void writeloop(Output* out)
+{
+	outlock(out);
+	for (;;)
+	{
+		while (out->backlen == 0 && !out->closing)	// Wait for next block
+			outwait(out);
+
+		if (out->backlen == 0)	// Output closed and everything written
+			break;
+
+		outunlock(out);	// Write without holding the lock, so that next block can be filled meanwhile
+		fwrite(out->back, 1, out->backlen, out->file);
+		outlock(out);
+
+		out->backlen = 0;	// Block written, notify waiting submitter
+		outwake(out);
+	}
+	outunlock(out);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI writer(LPVOID out)
+{
+	writeloop((Output*)out);
+	return 0;
+}
+#else
+static void* writer(void* out)
+{
+	writeloop((Output*)out);
+	return NULL;
+}
+#endif
+
+/*
+ *	Allocate memory for output block
+ */
+static char* allocblock(void)
+{
+	char* ptr = (char*)malloc(OUTBUF_LEN + 1); // One more for terminating '\0' of outprintf
+	if (ptr == NULL)
+	{
+		fprintf(stderr, "Could not allocate memory for output!\n");
+		return NULL;
+	}
+
+	return ptr;
+}
+
+/*
+ *	Pass filled block to file, either directly or to writer thread
+ */
+static void submit(Output* out)
+{
+	char* tmp;
+
+	if (out->len == 0) // Nothing to write
+		return;
+
+	if (!out->async) // Write it ourselves
+	{
+		fwrite(out->buf, 1, out->len, out->file);
+		out->len = 0;
+		return;
+	}
+
+	outlock(out);
+	while (out->backlen)	// Writer is still busy with previous block
+		outwait(out);
+
+	tmp = out->back;		// Swap blocks, writer gets the filled one and we continue with the other one
+	out->back = out->buf;
+	out->buf = tmp;
+	out->backlen = out->len;
+	out->len = 0;
+
+	outwake(out);
+	outunlock(out);
+}
+
+/*
+ *	Initialize output to given file, with writer thread if async is set. Returns 0 if memory could not be allocated
+ */
+int outopen(Output* out, FILE* file, int async)
+{
+	out->file = file;
+	if ((out->buf = allocblock()) == NULL)
+		return 0;
+	out->len = 0;
+	out->back = NULL;
+	out->backlen = 0;
+	out->async = 0;
+	out->closing = 0;
+
+	if (!async)
+		return 1;
+
+	if ((out->back = allocblock()) == NULL)
+	{
+		free(out->buf);
+		return 0;
+	}
+#if defined(_WIN32)
+	InitializeCriticalSection(&out->lock);
+	InitializeConditionVariable(&out->cond);
+	out->async = (out->thread = CreateThread(NULL, 0, writer, out, 0, NULL)) != NULL;
+	if (!out->async)
+		DeleteCriticalSection(&out->lock);
+#else
+	pthread_mutex_init(&out->lock, NULL);
+	pthread_cond_init(&out->cond, NULL);
+	out->async = pthread_create(&out->thread, NULL, writer, out) == 0;
+	if (!out->async)
+	{
+		pthread_mutex_destroy(&out->lock);
+		pthread_cond_destroy(&out->cond);
+	}
+#endif
+
+	if (!out->async) // Thread could not be started, fall back to synchronous writes
+		fprintf(stderr, "Could not start writer thread, writing synchronously\n");
+
+	return 1;
+}
+
+/*
+ *	Write given characters to output
+ */
+void outwrite(Output* out, const char* str, size_t len)
+{
+	size_t part;
+
+	if (!out->async && len >= OUTBUF_LEN) // Big chunk, write it directly without copying
+	{
+		submit(out);
+		fwrite(str, 1, len, out->file);
+		return;
+	}
+
+	while (len > OUTBUF_LEN - out->len) // Fill block to the end and submit it
+	{
+		part = OUTBUF_LEN - out->len;
+		memcpy(out->buf + out->len, str, part);
+		out->len += part;
+		str += part;
+		len -= part;
+		submit(out);
+	}
+
+	memcpy(out->buf + out->len, str, len);
+	out->len += len;
+}
+
+/*
+ *	Write single character to output
+ */
+void outputc(Output* out, char c)
+{
+	if (out->len == OUTBUF_LEN)
+		submit(out);
+
+	out->buf[out->len++] = c;
+}
+
+/*
+ *	Write formatted string to output
+ */
+void outprintf(Output* out, const char* format, ...)
+{
+	va_list args;
+	int len;
+
+	va_start(args, format);
+	len = vsnprintf(out->buf + out->len, OUTBUF_LEN + 1 - out->len, format, args);
+	va_end(args);
+
+	if (len < 0)	// Formatting error
+		return;
+
+	if ((size_t)len > OUTBUF_LEN - out->len)	// Did not fit, submit block and format again into empty one
+	{
+		submit(out);
+		va_start(args, format);
+		len = vsnprintf(out->buf, OUTBUF_LEN + 1, format, args);
+		va_end(args);
+		if (len > OUTBUF_LEN)	// Longer than whole block, truncate
+			len = OUTBUF_LEN;
+	}
+
+	out->len += len;
+}
+
+/*
+ *	Write all buffered data to file
+ */
+void outflush(Output* out)
+{
+	submit(out);
+
+	if (out->async) // Wait for writer to finish last block
+	{
+		outlock(out);
+		while (out->backlen)
+			outwait(out);
+		outunlock(out);
+	}
+
+	fflush(out->file);
+}
+
+/*
+ *	Flush output, stop writer thread and free buffers
+ */
+void outclose(Output* out)
+{
+	outflush(out);
+
+	if (out->async)
+	{
+		outlock(out);
+		out->closing = 1;
+		outwake(out);
+		outunlock(out);
+
+#if defined(_WIN32)
+		WaitForSingleObject(out->thread, INFINITE);
+		CloseHandle(out->thread);
+		DeleteCriticalSection(&out->lock);
+#else
+		pthread_join(out->thread, NULL);
+		pthread_mutex_destroy(&out->lock);
+		pthread_cond_destroy(&out->cond);
+#endif
+		out->async = 0;
+	}
+
+	free(out->buf);
+	free(out->back);
+	out->buf = out->back = NULL;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/*
+ *	Size of single output block
+ */
+#define OUTBUF_LEN	(1 << 20)
+
+/*
+ *	Buffered output, optionally written to file by background thread
+ */
+typedef struct {
+	FILE*	file;
+	char*	buf;		// Block being filled
+	size_t	len;
+	char*	back;		// Block being written by writer thread
+	size_t	backlen;
+	int		async;
+	int		closing;
+#if defined(_WIN32)
+	HANDLE				thread;
+	CRITICAL_SECTION	lock;
+	CONDITION_VARIABLE	cond;
+#else
+	pthread_t			thread;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+#endif
+} Output;
+
+int outopen(Output* out, FILE* file, int async);
+void outwrite(Output* out, const char* str, size_t len);
+void outputc(Output* out, char c);
+void outprintf(Output* out, const char* format, ...);
+void outflush(Output* out);
+void outclose(Output* out);
+
+#endif /* !OUTPUT_H */
\ No newline at end of file
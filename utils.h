@@ -10,6 +10,12 @@ typedef SSIZE_T ssize_t;
 #define MINSSIZE_T  ((SSIZE_T)~MAXSSIZE_T)
 #endif
 
+#if defined(_MSC_VER)
+#define RESTRICT	__restrict
+#else
+#define RESTRICT	restrict
+#endif
+
 #define strip(string)	{(string)[strlen(string) - 1] = '\0';}
 
 #endif // !UTILS_H